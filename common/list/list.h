@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 #include <assert.h>
+#include <stdint.h>
 
 // 这里提供了一个内核双向链表的实现
 
@@ -0,0 +1,596 @@
+#include "depscan.h"
+
+// 扫描过程
+const char *skip_line_rest(const char *p);
+const char *skip_blanks(const char *p);
+const char *skip_blank_lines(const char *p);
+const char *skip_block_comment(const char *p);
+const char *parse_directive(const char *p, LIST_NODE *dependency_list_head);
+int is_include_guard(const char *p, const char *name, long name_length);
+int is_end_of_file(const char *p);
+void drop_include_guard(LIST_NODE *dependency_list_head);
+
+// 辅助函数
+void count_newlines(const char *from, const char *to);
+int is_line_continued(const char *line_start, const char *line_end);
+int is_blank(char c);
+int is_identifier_char(char c);
+int is_directive(const char *name, long length, const char *directive);
+void print_make_chars(const char *str, long length);
+void print_make_path(const char *directory, long directory_length, const char *path);
+unsigned long hash_path(const char *path);
+void print_json_string(const char *str);
+
+// 源代码结尾（最后一个字符的下一个位置）
+const char *scan_end;
+// 当前行号
+long scan_line;
+// 当前 #if 系列条件块的嵌套深度
+long condition_depth;
+// 最外层条件块是否是头文件保护（#ifndef X 紧跟 #define X），是则为1
+long include_guard;
+// 文件的第一条内容（跳过开头的空白和注释），只有从这里开始的 #ifndef 才可能是头文件保护
+const char *first_content;
+// 头文件保护开始时依赖项链表的最后一个结点，之后加入的依赖项都在头文件保护内
+LIST_NODE *guard_start;
+
+/**
+ * 扫描源代码中的 #include 依赖
+ * 条件编译不求值，所有分支里的 #include 都会被记录（conditional 标记为1）
+ * @param source_code 指向源代码的指针
+ * @param length 源代码长度（字节）
+ * @return 返回指向依赖项链表头结点的指针
+ */
+LIST_NODE *scan_dependencies(const char *source_code, long length) {
+    // 创建一个新的依赖项链表的头结点
+    LIST_NODE *dependency_list_head = (LIST_NODE *)malloc(sizeof(LIST_NODE));
+
+    // 检查内存分配是否成功
+    if (dependency_list_head == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for dependency list\n");
+        return dependency_list_head;
+    }
+
+    init_list_node(dependency_list_head);
+
+    scan_end = source_code + length;
+    scan_line = 1;
+    condition_depth = 0;
+    include_guard = 0;
+    first_content = skip_blank_lines(source_code);
+    guard_start = NULL;
+
+    // 每次循环都从一个逻辑行的行首开始
+    const char *p = source_code;
+    while (p < scan_end) {
+        // 跳过行首空白和块注释（块注释等同于空白），只有 '#' 开头的行才需要解析
+        p = skip_blanks(p);
+        if (p < scan_end && *p == '#') {
+            p = parse_directive(p + 1, dependency_list_head);
+        }
+
+        // 行的剩余部分（包括其中的注释）整段跳过
+        p = skip_line_rest(p);
+    }
+
+    // 没有闭合的 #ifndef 不是头文件保护
+    if (include_guard) {
+        drop_include_guard(dependency_list_head);
+    }
+
+    return dependency_list_head;
+}
+
+/**
+ * 跳过当前逻辑行的剩余部分，返回下一行的行首
+ * 没有 '/' 的行不可能开启注释，直接用 memchr 跳到行尾；
+ * 有 '/' 的行才逐字符扫描，识别字符串、字符常量和注释（块注释可能跨行）
+ * @param p 当前位置
+ * @return 返回下一个逻辑行的行首
+ */
+const char *skip_line_rest(const char *p) {
+    const char *line_start = p;
+
+    while (p < scan_end) {
+        const char *newline = memchr(p, '\n', scan_end - p);
+        const char *line_end = newline != NULL ? newline : scan_end;
+
+        // 慢速路径：这一行里可能有注释
+        const char *slash = memchr(p, '/', line_end - p);
+        if (slash != NULL) {
+            int in_comment = 0;
+            while (p < line_end) {
+                if (*p == '"' || *p == '\'') {
+                    // 字符串和字符常量中的 "/*" 不是注释，跳到配对的引号
+                    char quote = *p++;
+                    while (p < line_end && *p != quote) {
+                        if (*p == '\\' && p + 1 < line_end) {
+                            p++;
+                        }
+                        p++;
+                    }
+                    if (p < line_end) {
+                        p++;  // 跳过结尾的引号
+                    }
+                } else if (*p == '/' && p + 1 < line_end && p[1] == '/') {
+                    // 行注释，直接到行尾
+                    p = line_end;
+                } else if (*p == '/' && p + 1 < line_end && p[1] == '*') {
+                    // 块注释，结束后所在的行可能已经变了，重新计算行尾
+                    p = skip_block_comment(p + 2);
+                    in_comment = 1;
+                    break;
+                } else {
+                    p++;
+                }
+            }
+            if (in_comment) {
+                line_start = p;
+                continue;
+            }
+        }
+
+        // 到达行尾
+        if (newline == NULL) {
+            return scan_end;
+        }
+        scan_line++;
+        p = newline + 1;
+
+        // 反斜杠续行时下一物理行不是新的逻辑行
+        if (!is_line_continued(line_start, newline)) {
+            return p;
+        }
+        line_start = p;
+    }
+
+    return p;
+}
+
+/**
+ * 跳过行内空白和块注释
+ * @param p 当前位置
+ * @return 返回第一个既不是空白也不在块注释中的位置
+ */
+const char *skip_blanks(const char *p) {
+    while (p < scan_end) {
+        if (is_blank(*p)) {
+            p++;
+        } else if (*p == '/' && p + 1 < scan_end && p[1] == '*') {
+            p = skip_block_comment(p + 2);
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+/**
+ * 跳过块注释
+ * @param p 块注释开头的 "/" 和 "*" 之后的位置
+ * @return 返回块注释结尾 "*\/" 之后的位置，注释未闭合返回源代码结尾
+ */
+const char *skip_block_comment(const char *p) {
+    const char *star;
+    while ((star = memchr(p, '*', scan_end - p)) != NULL) {
+        if (star + 1 < scan_end && star[1] == '/') {
+            count_newlines(p, star);
+            return star + 2;
+        }
+        count_newlines(p, star + 1);
+        p = star + 1;
+    }
+
+    count_newlines(p, scan_end);
+    return scan_end;
+}
+
+/**
+ * 解析一条预处理指令，只处理 #include 和 #if 系列指令
+ * @param p '#' 之后的位置
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ * @return 返回指令解析结束的位置（行的剩余部分由调用者跳过）
+ */
+const char *parse_directive(const char *p, LIST_NODE *dependency_list_head) {
+    const char *hash = p - 1;  // '#' 的位置
+    p = skip_blanks(p);
+
+    // 读取指令名
+    const char *name = p;
+    while (p < scan_end && *p >= 'a' && *p <= 'z') {
+        p++;
+    }
+    long name_length = p - name;
+
+    if (is_directive(name, name_length, "ifndef") && hash == first_content) {
+        // 文件开头的 #ifndef X 紧跟 #define X 可能是头文件保护，里面的 #include 暂时不算条件包含，
+        // 到对应的 #endif 再确认它之后是否已经到了文件结尾
+        const char *macro = skip_blanks(p);
+        const char *macro_end = macro;
+        while (macro_end < scan_end && is_identifier_char(*macro_end)) {
+            macro_end++;
+        }
+        include_guard = is_include_guard(macro_end, macro, macro_end - macro);
+        guard_start = dependency_list_head->prev;
+        condition_depth++;
+        return macro_end;
+    }
+    if (is_directive(name, name_length, "if") ||
+        is_directive(name, name_length, "ifdef") ||
+        is_directive(name, name_length, "ifndef")) {
+        condition_depth++;
+        return p;
+    }
+    if (is_directive(name, name_length, "else") || is_directive(name, name_length, "elif")) {
+        // 带 #else 分支的不是头文件保护
+        if (condition_depth == 1 && include_guard) {
+            drop_include_guard(dependency_list_head);
+        }
+        return p;
+    }
+    if (is_directive(name, name_length, "endif")) {
+        if (condition_depth > 0) {
+            condition_depth--;
+        }
+        if (condition_depth == 0 && include_guard) {
+            // #endif 之后还有内容，说明这只是普通的条件块
+            if (!is_end_of_file(p)) {
+                drop_include_guard(dependency_list_head);
+            }
+            include_guard = 0;
+        }
+        return p;
+    }
+    if (!is_directive(name, name_length, "include")) {
+        // #define 等指令与依赖关系无关
+        return p;
+    }
+
+    p = skip_blanks(p);
+
+    // 用宏展开得到文件名的 #include 无法在不做预处理的情况下确定，忽略
+    char terminator;
+    IncludeKind kind;
+    if (p < scan_end && *p == '"') {
+        terminator = '"';
+        kind = INCLUDE_QUOTED;
+    } else if (p < scan_end && *p == '<') {
+        terminator = '>';
+        kind = INCLUDE_ANGLED;
+    } else {
+        return p;
+    }
+
+    const char *path = ++p;
+    while (p < scan_end && *p != terminator && *p != '\n') {
+        p++;
+    }
+    if (p >= scan_end || *p != terminator) {
+        fprintf(stderr, "Warning: Unterminated #include at line %ld\n", scan_line);
+        return p;
+    }
+
+    long path_length = p - path;
+    p++;  // 跳过结尾的 '"' 或 '>'
+
+    Dependency *dependency = (Dependency *)malloc(sizeof(Dependency));
+    if (dependency == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for new dependency\n");
+        return p;
+    }
+    memset(dependency, 0, sizeof(*dependency));
+
+    if (path_length > (long)sizeof(dependency->path) - 1) {
+        path_length = sizeof(dependency->path) - 1;
+    }
+    memcpy(dependency->path, path, path_length);
+    dependency->kind = kind;
+    dependency->line = scan_line;
+    dependency->conditional = condition_depth - include_guard > 0;
+    init_list_node(&dependency->node);
+
+    list_add_tail(&dependency->node, dependency_list_head);
+    return p;
+}
+
+/**
+ * 判断 #ifndef 之后的下一条指令是否是同一个宏的 #define（中间只允许空行和注释）
+ * 只向前看，不改变当前行号
+ * @param p #ifndef 宏名之后的位置
+ * @param name 宏名起始位置（不以\0结尾）
+ * @param name_length 宏名长度
+ * @return 是头文件保护返回1，否则返回0
+ */
+int is_include_guard(const char *p, const char *name, long name_length) {
+    if (name_length == 0) {
+        return 0;
+    }
+
+    long saved_line = scan_line;
+    p = skip_blank_lines(skip_line_rest(p));
+    scan_line = saved_line;
+
+    if (p >= scan_end || *p != '#') {
+        return 0;
+    }
+    p = skip_blanks(p + 1);
+    if (scan_end - p < 6 || memcmp(p, "define", 6) != 0) {
+        return 0;
+    }
+    p = skip_blanks(p + 6);
+    scan_line = saved_line;  // 块注释会累加行号，恢复
+
+    return scan_end - p >= name_length && memcmp(p, name, name_length) == 0 &&
+           (p + name_length >= scan_end || !is_identifier_char(p[name_length]));
+}
+
+/**
+ * 跳过空白、空行和注释，只向前看，不改变当前行号
+ * @param p 当前位置
+ * @return 返回第一个既不是空白也不在注释中的位置
+ */
+const char *skip_blank_lines(const char *p) {
+    long saved_line = scan_line;
+    for (;;) {
+        p = skip_blanks(p);
+        if (p < scan_end && *p == '\n') {
+            p++;
+        } else if (p + 1 < scan_end && p[0] == '/' && p[1] == '/') {
+            p = skip_line_rest(p);
+        } else {
+            break;
+        }
+    }
+    scan_line = saved_line;
+    return p;
+}
+
+/**
+ * 判断当前行的剩余部分之后是否只剩空白和注释
+ * @param p 当前位置
+ * @return 到了文件结尾返回1，否则返回0
+ */
+int is_end_of_file(const char *p) {
+    long saved_line = scan_line;
+    p = skip_blank_lines(skip_line_rest(p));
+    scan_line = saved_line;
+    return p >= scan_end;
+}
+
+/**
+ * 取消头文件保护：头文件保护内已经记录的依赖项都改为条件包含
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ */
+void drop_include_guard(LIST_NODE *dependency_list_head) {
+    LIST_NODE *pos;
+    for (pos = guard_start->next; pos != dependency_list_head; pos = pos->next) {
+        list_entry(pos, Dependency, node)->conditional = 1;
+    }
+    include_guard = 0;
+}
+
+/**
+ * 统计区间内的换行符数量并累加到当前行号
+ * @param from 区间起点（包含）
+ * @param to 区间终点（不包含）
+ */
+void count_newlines(const char *from, const char *to) {
+    while (from < to && (from = memchr(from, '\n', to - from)) != NULL) {
+        scan_line++;
+        from++;
+    }
+}
+
+/**
+ * 判断一行是否以反斜杠续行（允许 "\\\r\n" 的写法）
+ * @param line_start 行首
+ * @param line_end 行尾换行符的位置
+ * @return 续行返回1，否则返回0
+ */
+int is_line_continued(const char *line_start, const char *line_end) {
+    if (line_end > line_start && line_end[-1] == '\r') {
+        line_end--;
+    }
+    return line_end > line_start && line_end[-1] == '\\';
+}
+
+/**
+ * 判断字符是否是行内空白
+ * @param c 要检查的字符
+ * @return 是空白返回1，否则返回0
+ */
+int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+/**
+ * 判断字符是否可以出现在标识符中
+ * @param c 要检查的字符
+ * @return 可以返回1，否则返回0
+ */
+int is_identifier_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * 判断指令名是否是给定的指令
+ * @param name 指令名起始位置（不以\0结尾）
+ * @param length 指令名长度
+ * @param directive 要比较的指令
+ * @return 相同返回1，否则返回0
+ */
+int is_directive(const char *name, long length, const char *directive) {
+    return (long)strlen(directive) == length && memcmp(name, directive, length) == 0;
+}
+
+/**
+ * 打印 Makefile 中的一段文字，空格和 '#' 用反斜杠转义，'$' 写成 "$$"，避免被 make 当成分隔符、注释或变量
+ * @param str 要打印的文字
+ * @param length 文字长度
+ */
+void print_make_chars(const char *str, long length) {
+    for (long i = 0; i < length; i++) {
+        if (str[i] == ' ' || str[i] == '#') {
+            putchar('\\');
+        } else if (str[i] == '$') {
+            putchar('$');
+        }
+        putchar(str[i]);
+    }
+}
+
+/**
+ * 打印 Makefile 中的路径
+ * @param directory 路径前缀（源文件所在目录，包括末尾的分隔符）
+ * @param directory_length 路径前缀长度
+ * @param path 路径
+ */
+void print_make_path(const char *directory, long directory_length, const char *path) {
+    print_make_chars(directory, directory_length);
+    print_make_chars(path, (long)strlen(path));
+}
+
+/**
+ * 计算路径的哈希值（FNV-1a）
+ * @param path 路径
+ * @return 返回哈希值
+ */
+unsigned long hash_path(const char *path) {
+    unsigned long hash = 2166136261UL;
+    for (; *path != '\0'; path++) {
+        hash ^= (unsigned char)*path;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/**
+ * 打印 JSON 字符串，双引号、反斜杠和控制字符需要转义
+ * @param str 要打印的字符串
+ */
+void print_json_string(const char *str) {
+    putchar('"');
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            putchar('\\');
+            putchar(*str);
+        } else if ((unsigned char)*str < 0x20) {
+            printf("\\u%04x", (unsigned char)*str);
+        } else {
+            putchar(*str);
+        }
+    }
+    putchar('"');
+}
+
+/**
+ * 以 Makefile 规则的形式打印依赖列表
+ * 只列出本文件直接包含的头文件，不递归展开被包含的头文件，所以不等同于 gcc -MM
+ * 双引号形式的依赖按源文件所在目录拼接路径，尖括号形式的系统头文件不输出
+ * 路径中的空格和 '#' 用反斜杠转义，'$' 写成 "$$"
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ * @param source_path 源文件路径
+ */
+void print_dependencies_make(LIST_NODE *dependency_list_head, const char *source_path) {
+    // 源文件所在目录（包括末尾的分隔符），双引号形式的 #include 先在这里查找
+    const char *basename = source_path;
+    const char *cursor;
+    for (cursor = source_path; *cursor != '\0'; cursor++) {
+        if (*cursor == '/' || *cursor == '\\') {
+            basename = cursor + 1;
+        }
+    }
+    long directory_length = basename - source_path;
+
+    // 目标文件名：去掉目录，扩展名换成 .o
+    const char *extension = strrchr(basename, '.');
+    long stem_length = extension != NULL ? extension - basename : (long)strlen(basename);
+    print_make_chars(basename, stem_length);
+    printf(".o: ");
+    print_make_path(source_path, 0, source_path);
+
+    // 同一个头文件可能在多个条件分支中出现，用开放寻址的哈希表去重，只输出一次
+    // 表的大小取不小于依赖项数量两倍的2的幂，下标用哈希值和 (大小 - 1) 按位与得到
+    LIST_NODE *pos;
+    long dependency_count = 0;
+    list_for_each(pos, dependency_list_head) {
+        dependency_count++;
+    }
+    unsigned long table_size = 16;
+    while (table_size < (unsigned long)dependency_count * 2) {
+        table_size *= 2;
+    }
+    Dependency **table = (Dependency **)calloc(table_size, sizeof(Dependency *));
+    if (table == NULL) {
+        // 去重失败不影响正确性，重复的依赖对 make 没有影响
+        fprintf(stderr, "Warning: Failed to allocate memory for dependency table\n");
+    }
+
+    list_for_each(pos, dependency_list_head) {
+        Dependency *dependency = list_entry(pos, Dependency, node);
+        if (dependency->kind != INCLUDE_QUOTED) {
+            continue;
+        }
+
+        if (table != NULL) {
+            unsigned long slot = hash_path(dependency->path) & (table_size - 1);
+            while (table[slot] != NULL && strcmp(table[slot]->path, dependency->path) != 0) {
+                slot = (slot + 1) & (table_size - 1);
+            }
+            if (table[slot] != NULL) {
+                continue;  // 已经输出过
+            }
+            table[slot] = dependency;
+        }
+
+        printf(" \\\n  ");
+        // 绝对路径不拼接源文件目录
+        if (dependency->path[0] == '/' || (dependency->path[0] != '\0' && dependency->path[1] == ':')) {
+            print_make_path(source_path, 0, dependency->path);
+        } else {
+            print_make_path(source_path, directory_length, dependency->path);
+        }
+    }
+    printf("\n");
+
+    free(table);
+}
+
+/**
+ * 以 JSON 的形式打印依赖列表（包括尖括号形式的依赖）
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ * @param source_path 源文件路径
+ */
+void print_dependencies_json(LIST_NODE *dependency_list_head, const char *source_path) {
+    printf("{\n  \"source\": ");
+    print_json_string(source_path);
+    printf(",\n  \"includes\": [");
+
+    int first = 1;
+    LIST_NODE *pos;
+    list_for_each(pos, dependency_list_head) {
+        Dependency *dependency = list_entry(pos, Dependency, node);
+        printf(first ? "\n    {\"path\": " : ",\n    {\"path\": ");
+        print_json_string(dependency->path);
+        printf(", \"kind\": \"%s\", \"line\": %ld, \"conditional\": %s}",
+               dependency->kind == INCLUDE_QUOTED ? "quoted" : "angled",
+               dependency->line,
+               dependency->conditional ? "true" : "false");
+        first = 0;
+    }
+
+    printf(first ? "]\n}\n" : "\n  ]\n}\n");
+}
+
+/**
+ * 释放依赖项链表
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ */
+void free_dependencies(LIST_NODE *dependency_list_head) {
+    LIST_NODE *pos, *n;
+    list_for_each_safe(pos, n, dependency_list_head) {
+        list_del(pos);
+        free(list_entry(pos, Dependency, node));
+    }
+    free(dependency_list_head);
+}
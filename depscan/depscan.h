@@ -0,0 +1,63 @@
+#ifndef HC_COMPILER_DEPSCAN_H
+#define HC_COMPILER_DEPSCAN_H
+
+// 依赖扫描器
+// 构建系统只需要 #include 依赖关系，没必要把每个标识符、数字和字符串都做一遍完整的词法分析
+// 这里按行跳跃扫描：用 memchr 直接找行首，不是预处理指令的行和注释整段跳过，
+// 只解析 #include 和 #if 系列指令，最后输出 Makefile 格式或 JSON 格式的依赖列表
+
+#include <stdio.h>
+#include <string.h>
+#include "../common/list/list.h"
+
+// #include 的写法
+typedef enum {
+    INCLUDE_QUOTED,    // #include "file"
+    INCLUDE_ANGLED     // #include <file>
+} IncludeKind;
+
+// 依赖项结构体
+typedef struct dependency_struct {
+    IncludeKind kind;   // #include 的写法
+    char path[256];     // 被包含的文件名（按源代码原样保存）
+    long line;          // #include 所在行
+    int conditional;    // 是否位于 #if / #ifdef / #ifndef 条件块内（头文件保护不算）
+    LIST_NODE node;     // 双向链表结点
+} Dependency;
+
+/**
+ * 扫描源代码中的 #include 依赖
+ * 条件编译不求值，所有分支里的 #include 都会被记录（conditional 标记为1）
+ * 头文件保护不算条件编译：文件的第一条内容是 #ifndef X、紧跟 #define X、
+ * 并且对应的 #endif 之后直到文件结尾只有空白和注释时（与 gcc 的多重包含检测规则相同），
+ * 其中的 #include 不标记为条件包含
+ * @param source_code 指向源代码的指针
+ * @param length 源代码长度（字节）
+ * @return 返回指向依赖项链表头结点的指针
+ */
+LIST_NODE *scan_dependencies(const char *source_code, long length);
+
+/**
+ * 以 Makefile 规则的形式打印依赖列表
+ * 只列出本文件直接包含的头文件，不递归展开被包含的头文件，所以不等同于 gcc -MM
+ * 双引号形式的依赖按源文件所在目录拼接路径，尖括号形式的系统头文件不输出
+ * 路径中的空格和 '#' 用反斜杠转义，'$' 写成 "$$"
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ * @param source_path 源文件路径
+ */
+void print_dependencies_make(LIST_NODE *dependency_list_head, const char *source_path);
+
+/**
+ * 以 JSON 的形式打印依赖列表（包括尖括号形式的依赖）
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ * @param source_path 源文件路径
+ */
+void print_dependencies_json(LIST_NODE *dependency_list_head, const char *source_path);
+
+/**
+ * 释放依赖项链表
+ * @param dependency_list_head 指向依赖项链表头结点的指针
+ */
+void free_dependencies(LIST_NODE *dependency_list_head);
+
+#endif //HC_COMPILER_DEPSCAN_H
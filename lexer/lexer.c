@@ -13,6 +13,24 @@ const char* keywords[] = {
         "volatile", "while"
 };
 
+// 标点符号拼写表，按 TokenType 下标访问
+const char* punctuators[] = {
+        [TOKEN_LPAREN] = "(", [TOKEN_RPAREN] = ")", [TOKEN_LBRACE] = "{", [TOKEN_RBRACE] = "}",
+        [TOKEN_LBRACKET] = "[", [TOKEN_RBRACKET] = "]", [TOKEN_SEMICOLON] = ";", [TOKEN_COMMA] = ",",
+        [TOKEN_PERIOD] = ".", [TOKEN_ELLIPSIS] = "...", [TOKEN_ARROW] = "->",
+        [TOKEN_INCREMENT] = "++", [TOKEN_DECREMENT] = "--",
+        [TOKEN_PLUS] = "+", [TOKEN_MINUS] = "-", [TOKEN_STAR] = "*", [TOKEN_SLASH] = "/",
+        [TOKEN_PERCENT] = "%", [TOKEN_AMPERSAND] = "&", [TOKEN_PIPE] = "|", [TOKEN_CARET] = "^",
+        [TOKEN_TILDE] = "~", [TOKEN_EXCLAMATION] = "!", [TOKEN_LESS] = "<", [TOKEN_GREATER] = ">",
+        [TOKEN_LESS_EQUAL] = "<=", [TOKEN_GREATER_EQUAL] = ">=", [TOKEN_EQUAL] = "==",
+        [TOKEN_NOT_EQUAL] = "!=", [TOKEN_LOGICAL_AND] = "&&", [TOKEN_LOGICAL_OR] = "||",
+        [TOKEN_LEFT_SHIFT] = "<<", [TOKEN_RIGHT_SHIFT] = ">>", [TOKEN_QUESTION] = "?", [TOKEN_COLON] = ":",
+        [TOKEN_ASSIGN] = "=", [TOKEN_PLUS_ASSIGN] = "+=", [TOKEN_MINUS_ASSIGN] = "-=",
+        [TOKEN_STAR_ASSIGN] = "*=", [TOKEN_SLASH_ASSIGN] = "/=", [TOKEN_PERCENT_ASSIGN] = "%=",
+        [TOKEN_AND_ASSIGN] = "&=", [TOKEN_OR_ASSIGN] = "|=", [TOKEN_XOR_ASSIGN] = "^=",
+        [TOKEN_LEFT_SHIFT_ASSIGN] = "<<=", [TOKEN_RIGHT_SHIFT_ASSIGN] = ">>="
+};
+
 // 需要实现的函数有三个功能部分：
 // 字符处理
 // Token处理
@@ -24,6 +42,7 @@ void init_lexer(const char *source_code);
 char current_char();
 void next_char();
 char peek();
+int accept_char(char expected);
 
 // token处理
 
@@ -33,11 +52,10 @@ void append_token(Token *new_token, LIST_NODE *token_list_head);
 // 词法分析
 Token* lex_identifier_or_keyword();
 Token* lex_number();
-Token* lex_operator();
+Token* lex_punctuator();
 Token* lex_string();
 Token* lex_char();
 Token* lex_preprocessor();
-Token* lex_symbol();
 
 // 除此之外还有一些抽出复用的辅助函数：
 
@@ -101,10 +119,23 @@ char peek() {
     return source_code_ptr[current_index + 1];  // 返回下一个字符
 }
 
+/**
+ * 如果当前字符是期望的字符，就移动到下一个字符
+ * @param expected 期望的字符
+ * @return 匹配并前进返回1，否则返回0
+ */
+int accept_char(char expected) {
+    if (current_char() != expected) {
+        return 0;
+    }
+    next_char();
+    return 1;
+}
+
 /**
  * 创建一个新的 Token 并初始化其类型和值
  * @param type Token 的类型
- * @param value Token 的值
+ * @param value Token 的值，标点符号传NULL（不拷贝值）
  * @param line Token 所在行号
  * @param column Token 起始列号
  * @return 返回指向新创建 Token 的指针
@@ -119,19 +150,22 @@ Token* create_token(TokenType type, const char *value, long line, long column) {
         return new_token;
     }
 
-    // 先用memset初始化全部为0，这样就不用担心了
-    memset(new_token, 0, sizeof(*new_token));
-
     // 设置 Token 类型
     new_token->type = type;
 
-    // 拷贝 Token 值
-    strncpy(new_token->value, value, sizeof(new_token->value) - 1);
-    // 之前已经memset为0，能够确保字符串结尾为\0，无需再次确保
+    // 拷贝 Token 值，标点符号的拼写由类型决定，只需置为空串，省掉整个缓冲区的拷贝
+    if (value != NULL) {
+        strncpy(new_token->value, value, sizeof(new_token->value) - 1);
+        new_token->value[sizeof(new_token->value) - 1] = '\0';  // 确保字符串结尾为\0
+    } else {
+        new_token->value[0] = '\0';
+    }
 
-    // 设置 Token 行和列信息
+    // 设置 Token 行和列信息，位置信息由 tokenize 填写
     new_token->line = line;
     new_token->column = column;
+    new_token->offset = 0;
+    new_token->length = 0;
 
     // 初始化 Token 中的链表节点
     init_list_node(&new_token->node);
@@ -157,8 +191,10 @@ void print_tokens(LIST_NODE *token_list_head) {
     LIST_NODE *pos;
     list_for_each(pos, token_list_head) {
         Token *token = list_entry(pos, Token, node);  // 获取 Token 的首地址
+        const char *spelling = punctuator_spelling(token->type);  // 标点符号没有保存值，按类型取拼写
         printf("Token: Type=%d, Value=%s, Line=%ld, Column=%ld\n",
-               token->type, token->value, token->line, token->column);  // 打印 Token 信息
+               token->type, spelling != NULL ? spelling : token->value,
+               token->line, token->column);  // 打印 Token 信息
     }
 }
 
@@ -191,49 +227,56 @@ LIST_NODE *tokenize(const char *source_code) {
     while (current_char() != '\0') {
         skip_whitespace();  // 跳过空白字符
 
+        // 跳过空白之后可能已经到达文件结尾
+        if (current_char() == '\0') {
+            break;
+        }
+
+        // 记录 token 的起始偏移，注释和未知字符不产生 token
+        long start_index = current_index;
+        Token* token = NULL;
+
         // 当前字符的类型判断
         if (is_letter(current_char())) {
             // 解析标识符或关键字
-            Token* token = lex_identifier_or_keyword();
-            append_token(token, token_list_head);
+            token = lex_identifier_or_keyword();
         } else if (is_digit(current_char())) {
             // 解析数字
-            Token* token = lex_number();
-            append_token(token, token_list_head);
+            token = lex_number();
         } else if (current_char() == '/' && (peek() == '/' || peek() == '*')) {
             // 不再解析注释，直接跳过
             skip_comment();
         } else if (current_char() == '#') {
             // 解析预处理指令
-            Token* token = lex_preprocessor();
-            append_token(token, token_list_head);
+            token = lex_preprocessor();
         } else if (current_char() == '"' || current_char() == '\'') {
             // 解析字符串或字符常量
             if (current_char() == '"') {
-                Token* token = lex_string();
-                append_token(token, token_list_head);
+                token = lex_string();
             } else {
-                Token* token = lex_char();
-                append_token(token, token_list_head);
+                token = lex_char();
             }
-        } else if (strchr("+-*/=!><&|?:", current_char())) {
-            // 解析运算符
-            Token* token = lex_operator();
-            append_token(token, token_list_head);
-        } else if (strchr("(){}[];,.", current_char())) {
-            // 解析符号
-            Token* token = lex_symbol();
-            append_token(token, token_list_head);
+        } else if (strchr("+-*/%=!<>&|^~?:(){}[];,.", current_char())) {
+            // 解析标点符号（运算符和分隔符）
+            token = lex_punctuator();
         } else {
             // 未知字符，忽略或报错处理
             fprintf(stderr, "Warning: Unrecognized character '%c' at line %ld, column %ld\n",
                     current_char(), current_line, current_column);
             next_char();  // 跳过这个字符，继续处理
         }
+
+        if (token != NULL) {
+            // 记录 token 在源代码中的位置，供位置索引等工具使用
+            token->offset = start_index;
+            token->length = current_index - start_index;
+            append_token(token, token_list_head);
+        }
     }
 
     // 解析结束后，添加文件结束标记
     Token* eof_token = create_token(TOKEN_EOF, "EOF", current_line, current_column);
+    eof_token->offset = current_index;
     append_token(eof_token, token_list_head);
 
     // 返回链表头结点
@@ -302,34 +345,80 @@ Token* lex_number() {
 }
 
 /**
- * 解析操作符
+ * 解析标点符号（运算符和分隔符）
+ * 按首字符分派，再用最长匹配吃掉后续字符，直接把类型写进 Token，不拷贝字符串
  * @return 返回解析到的 Token
  */
-Token* lex_operator() {
-    char buffer[3];  // 运算符长度通常不会超过2个字符
-    int length = 0;
-
-    buffer[length++] = current_char();
+Token* lex_punctuator() {
+    long line = current_line;
+    long column = current_column;
+    char c = current_char();
     next_char();
 
-    // 检查双字符运算符
-    if ((buffer[0] == '+' && current_char() == '+') ||
-        (buffer[0] == '-' && current_char() == '-') ||
-        (buffer[0] == '=' && current_char() == '=') ||
-        (buffer[0] == '!' && current_char() == '=') ||
-        (buffer[0] == '&' && current_char() == '&') ||
-        (buffer[0] == '|' && current_char() == '|')) {
-        buffer[length++] = current_char();
-        next_char();
-    }
-    buffer[length] = '\0';
-
-    // 支持问号 ? 和冒号 : 作为运算符
-    if (buffer[0] == '?' || buffer[0] == ':') {
-        return create_token(TOKEN_OPERATOR, buffer, current_line, current_column - length);
+    TokenType type;
+    switch (c) {
+        case '(': type = TOKEN_LPAREN; break;
+        case ')': type = TOKEN_RPAREN; break;
+        case '{': type = TOKEN_LBRACE; break;
+        case '}': type = TOKEN_RBRACE; break;
+        case '[': type = TOKEN_LBRACKET; break;
+        case ']': type = TOKEN_RBRACKET; break;
+        case ';': type = TOKEN_SEMICOLON; break;
+        case ',': type = TOKEN_COMMA; break;
+        case '?': type = TOKEN_QUESTION; break;
+        case ':': type = TOKEN_COLON; break;
+        case '~': type = TOKEN_TILDE; break;
+        case '.':
+            // ".." 不是合法的标点，只有连续三个点才是省略号
+            if (current_char() == '.' && peek() == '.') {
+                next_char();
+                next_char();
+                type = TOKEN_ELLIPSIS;
+            } else {
+                type = TOKEN_PERIOD;
+            }
+            break;
+        case '+':
+            type = accept_char('+') ? TOKEN_INCREMENT :
+                   accept_char('=') ? TOKEN_PLUS_ASSIGN : TOKEN_PLUS;
+            break;
+        case '-':
+            type = accept_char('-') ? TOKEN_DECREMENT :
+                   accept_char('=') ? TOKEN_MINUS_ASSIGN :
+                   accept_char('>') ? TOKEN_ARROW : TOKEN_MINUS;
+            break;
+        case '*': type = accept_char('=') ? TOKEN_STAR_ASSIGN : TOKEN_STAR; break;
+        case '/': type = accept_char('=') ? TOKEN_SLASH_ASSIGN : TOKEN_SLASH; break;
+        case '%': type = accept_char('=') ? TOKEN_PERCENT_ASSIGN : TOKEN_PERCENT; break;
+        case '^': type = accept_char('=') ? TOKEN_XOR_ASSIGN : TOKEN_CARET; break;
+        case '!': type = accept_char('=') ? TOKEN_NOT_EQUAL : TOKEN_EXCLAMATION; break;
+        case '=': type = accept_char('=') ? TOKEN_EQUAL : TOKEN_ASSIGN; break;
+        case '&':
+            type = accept_char('&') ? TOKEN_LOGICAL_AND :
+                   accept_char('=') ? TOKEN_AND_ASSIGN : TOKEN_AMPERSAND;
+            break;
+        case '|':
+            type = accept_char('|') ? TOKEN_LOGICAL_OR :
+                   accept_char('=') ? TOKEN_OR_ASSIGN : TOKEN_PIPE;
+            break;
+        case '<':
+            if (accept_char('<')) {
+                type = accept_char('=') ? TOKEN_LEFT_SHIFT_ASSIGN : TOKEN_LEFT_SHIFT;
+            } else {
+                type = accept_char('=') ? TOKEN_LESS_EQUAL : TOKEN_LESS;
+            }
+            break;
+        case '>':
+            if (accept_char('>')) {
+                type = accept_char('=') ? TOKEN_RIGHT_SHIFT_ASSIGN : TOKEN_RIGHT_SHIFT;
+            } else {
+                type = accept_char('=') ? TOKEN_GREATER_EQUAL : TOKEN_GREATER;
+            }
+            break;
+        default: return NULL;
     }
 
-    return create_token(TOKEN_OPERATOR, buffer, current_line, current_column - length);
+    return create_token(type, NULL, line, column);
 }
 
 /**
@@ -343,15 +432,22 @@ Token* lex_string() {
     next_char();  // 跳过开头的双引号
 
     while (current_char() != '"' && current_char() != '\0') {
-        if (current_char() == '\\') {  // 处理转义字符
-            buffer[length++] = current_char();
+        // 超出缓冲区的部分不保存到值里（完整内容仍可以按 offset 和 length 从源代码中取到）
+        if (current_char() == '\\' && peek() != '\0') {  // 处理转义字符
+            if (length < (int)sizeof(buffer) - 1) {
+                buffer[length++] = current_char();
+            }
             next_char();
         }
-        buffer[length++] = current_char();
+        if (length < (int)sizeof(buffer) - 1) {
+            buffer[length++] = current_char();
+        }
         next_char();
     }
 
-    next_char();  // 跳过结尾的双引号
+    if (current_char() == '"') {
+        next_char();  // 跳过结尾的双引号，字符串未闭合时不能越过结尾的 '\0'
+    }
     buffer[length] = '\0';
 
     return create_token(TOKEN_STRING, buffer, current_line, current_column - length);
@@ -367,14 +463,18 @@ Token* lex_char() {
 
     next_char();  // 跳过开头的单引号
 
-    if (current_char() == '\\') {  // 处理转义字符
+    if (current_char() == '\\' && peek() != '\0') {  // 处理转义字符
+        buffer[length++] = current_char();
+        next_char();
+    }
+    if (current_char() != '\0') {
         buffer[length++] = current_char();
         next_char();
     }
-    buffer[length++] = current_char();
-    next_char();
 
-    next_char();  // 跳过结尾的单引号
+    if (current_char() == '\'') {
+        next_char();  // 跳过结尾的单引号，字符常量未闭合时不能越过结尾的 '\0'
+    }
     buffer[length] = '\0';
 
     return create_token(TOKEN_CHAR, buffer, current_line, current_column - length);
@@ -387,41 +487,41 @@ Token* lex_char() {
 Token* lex_preprocessor() {
     char buffer[256];
     int length = 0;
+    long line = current_line;      // 指令可能续行，起始位置要在读取之前记录
+    long column = current_column;
 
-    while (current_char() != '\n' && current_char() != '\0') {
-        buffer[length++] = current_char();
+    char previous = '\0';         // 上一个字符
+    char second_previous = '\0';  // 上上个字符
+
+    while (current_char() != '\0') {
+        // 换行符前是反斜杠（允许中间夹一个 '\r'）表示续行，指令延续到下一行
+        if (current_char() == '\n' && previous != '\\' && !(previous == '\r' && second_previous == '\\')) {
+            break;
+        }
+
+        // 超出缓冲区的部分不保存到值里（完整内容仍可以按 offset 和 length 从源代码中取到）
+        if (length < (int)sizeof(buffer) - 1) {
+            buffer[length++] = current_char();
+        }
+        second_previous = previous;
+        previous = current_char();
         next_char();
     }
 
     buffer[length] = '\0';
-    return create_token(TOKEN_PREPROCESSOR, buffer, current_line, current_column - length);
+    return create_token(TOKEN_PREPROCESSOR, buffer, line, column);
 }
 
 /**
- * 解析符号（如括号、逗号等）
- * @return 返回解析到的 Token
+ * 获取标点符号类型对应的拼写
+ * @param type Token 的类型
+ * @return 标点符号返回其拼写，其他类型返回NULL
  */
-Token* lex_symbol() {
-    char buffer[2];
-    buffer[0] = current_char();  // 读取当前字符
-    buffer[1] = '\0';
-
-    TokenType type;
-    switch (buffer[0]) {
-        case '(': type = TOKEN_LPAREN; break;
-        case ')': type = TOKEN_RPAREN; break;
-        case '{': type = TOKEN_LBRACE; break;
-        case '}': type = TOKEN_RBRACE; break;
-        case '[': type = TOKEN_LBRACKET; break;
-        case ']': type = TOKEN_RBRACKET; break;
-        case ';': type = TOKEN_SEMICOLON; break;  // 分号解析
-        case ',': type = TOKEN_COMMA; break;
-        case '.': type = TOKEN_PERIOD; break;
-        default: return NULL;
+const char *punctuator_spelling(TokenType type) {
+    if (type < TOKEN_LPAREN || type > TOKEN_RIGHT_SHIFT_ASSIGN) {
+        return NULL;
     }
-
-    next_char();  // 移动到下一个字符
-    return create_token(type, buffer, current_line, current_column - 1);
+    return punctuators[type];
 }
 
 /**
@@ -476,7 +576,9 @@ void skip_comment() {
         while (current_char() != '\n' && current_char() != '\0') {  // 一直到行尾或者文件结束
             next_char();
         }
-        next_char();  // 跳过换行符
+        if (current_char() == '\n') {
+            next_char();  // 跳过换行符，文件结束时不能越过结尾的 '\0'
+        }
     }
     else if (current_char() == '/' && peek() == '*') {  // 块注释
         next_char();  // 跳过 '/'
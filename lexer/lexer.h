@@ -13,15 +13,16 @@
 #include <string.h>
 
 // 定义 Token 类型
+// 标点符号（运算符和分隔符）每一种都有自己的类型，后续阶段可以直接按类型分派，不需要比较字符串
 typedef enum {
     TOKEN_KEYWORD,     // 关键字
     TOKEN_IDENTIFIER,  // 标识符
     TOKEN_INT,         // 整数常量
     TOKEN_FLOAT,       // 浮点常量
-    TOKEN_OPERATOR,    // 操作符
     TOKEN_STRING,      // 字符串常量
     TOKEN_CHAR,        // 字符常量
     TOKEN_PREPROCESSOR, // 预处理指令
+    // C89 标点符号，从 TOKEN_LPAREN 到 TOKEN_RIGHT_SHIFT_ASSIGN 连续排列
     TOKEN_LPAREN,      // '('
     TOKEN_RPAREN,      // ')'
     TOKEN_LBRACE,      // '{'
@@ -31,18 +32,64 @@ typedef enum {
     TOKEN_SEMICOLON,   // ';'
     TOKEN_COMMA,       // ','
     TOKEN_PERIOD,      // '.'
+    TOKEN_ELLIPSIS,    // '...'
+    TOKEN_ARROW,       // '->'
+    TOKEN_INCREMENT,   // '++'
+    TOKEN_DECREMENT,   // '--'
+    TOKEN_PLUS,        // '+'
+    TOKEN_MINUS,       // '-'
+    TOKEN_STAR,        // '*'
+    TOKEN_SLASH,       // '/'
+    TOKEN_PERCENT,     // '%'
+    TOKEN_AMPERSAND,   // '&'
+    TOKEN_PIPE,        // '|'
+    TOKEN_CARET,       // '^'
+    TOKEN_TILDE,       // '~'
+    TOKEN_EXCLAMATION, // '!'
+    TOKEN_LESS,        // '<'
+    TOKEN_GREATER,     // '>'
+    TOKEN_LESS_EQUAL,  // '<='
+    TOKEN_GREATER_EQUAL, // '>='
+    TOKEN_EQUAL,       // '=='
+    TOKEN_NOT_EQUAL,   // '!='
+    TOKEN_LOGICAL_AND, // '&&'
+    TOKEN_LOGICAL_OR,  // '||'
+    TOKEN_LEFT_SHIFT,  // '<<'
+    TOKEN_RIGHT_SHIFT, // '>>'
+    TOKEN_QUESTION,    // '?'
+    TOKEN_COLON,       // ':'
+    TOKEN_ASSIGN,      // '='
+    TOKEN_PLUS_ASSIGN, // '+='
+    TOKEN_MINUS_ASSIGN, // '-='
+    TOKEN_STAR_ASSIGN, // '*='
+    TOKEN_SLASH_ASSIGN, // '/='
+    TOKEN_PERCENT_ASSIGN, // '%='
+    TOKEN_AND_ASSIGN,  // '&='
+    TOKEN_OR_ASSIGN,   // '|='
+    TOKEN_XOR_ASSIGN,  // '^='
+    TOKEN_LEFT_SHIFT_ASSIGN,  // '<<='
+    TOKEN_RIGHT_SHIFT_ASSIGN, // '>>='
     TOKEN_EOF          // 文件结束
 } TokenType;
 
 // Token 结构体
 typedef struct token_struct {
     TokenType type;     // token单元的类型
-    char value[256];    // token单元的值
+    char value[256];    // token单元的值（标点符号不保存值，拼写由类型决定）
     long line;          // 该token所在行
     long column;        // 该token起始列
+    long offset;        // 该token在源代码中的起始偏移（字节，从0开始）
+    long length;        // 该token在源代码中所占的字节数
     LIST_NODE node;     // 双向链表结点
 } Token;
 
+/**
+ * 获取标点符号类型对应的拼写
+ * @param type Token 的类型
+ * @return 标点符号返回其拼写，其他类型返回NULL
+ */
+const char *punctuator_spelling(TokenType type);
+
 /**
  * 打印链表中的所有 Token
  * @param token_list_head 指向要打印的 Token 链表头结点的指针
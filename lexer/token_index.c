@@ -0,0 +1,247 @@
+#include "token_index.h"
+
+// 辅助函数
+long upper_bound_in(const long *values, long low, long high, long target);
+long token_upper_bound(const TokenIndex *index, long offset);
+
+/**
+ * 在有序数组的 [low, high) 区间中查找第一个大于 target 的元素下标
+ * @param values 有序数组
+ * @param low 区间起始下标（包含）
+ * @param high 区间结束下标（不包含）
+ * @param target 要比较的值
+ * @return 返回第一个大于 target 的元素下标，没有则返回 high
+ */
+long upper_bound_in(const long *values, long low, long high, long target) {
+    while (low < high) {
+        long middle = low + (high - low) / 2;
+        if (values[middle] <= target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+/**
+ * 查找第一个起始偏移大于 offset 的 token 下标
+ * 先在稀疏块摘要里定位块，再在块内二分，块摘要很小，基本都在缓存里
+ * @param index 指向索引的指针
+ * @param offset 字节偏移
+ * @return 返回 token 下标，没有则返回 token_count
+ */
+long token_upper_bound(const TokenIndex *index, long offset) {
+    // 起始偏移不超过 offset 的块数量
+    long blocks = upper_bound_in(index->block_offsets, 0, index->block_count, offset);
+    if (blocks == 0) {
+        return 0;
+    }
+
+    // 答案一定在最后一个满足条件的块里（下一块的第一个 token 已经大于 offset）
+    long low = (blocks - 1) * TOKEN_INDEX_BLOCK_SIZE;
+    long high = low + TOKEN_INDEX_BLOCK_SIZE;
+    if (high > index->token_count) {
+        high = index->token_count;
+    }
+    return upper_bound_in(index->offsets, low, high, offset);
+}
+
+/**
+ * 为 Token 流建立位置索引
+ * @param token_list_head 指向 tokenize 返回的 Token 链表头结点的指针
+ * @param source_code 指向生成该 Token 流的源代码字符串的指针
+ * @return 返回指向新建索引的指针，失败返回NULL
+ */
+TokenIndex *create_token_index(LIST_NODE *token_list_head, const char *source_code) {
+    TokenIndex *index = (TokenIndex *)malloc(sizeof(TokenIndex));
+    if (index == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for token index\n");
+        return index;
+    }
+    memset(index, 0, sizeof(*index));
+
+    // 统计 token 和换行的数量，一次性分配数组
+    LIST_NODE *pos;
+    list_for_each(pos, token_list_head) {
+        index->token_count++;
+    }
+
+    index->source_length = (long)strlen(source_code);
+    index->line_count = 1;
+    const char *cursor = source_code;
+    const char *end = source_code + index->source_length;
+    while ((cursor = memchr(cursor, '\n', end - cursor)) != NULL) {
+        index->line_count++;
+        cursor++;
+    }
+
+    index->block_count = (index->token_count + TOKEN_INDEX_BLOCK_SIZE - 1) / TOKEN_INDEX_BLOCK_SIZE;
+
+    // 多分配一个元素，避免 token 数量为0时 malloc(0) 返回NULL 被误判为失败
+    index->tokens = (Token **)malloc(sizeof(Token *) * (index->token_count + 1));
+    index->offsets = (long *)malloc(sizeof(long) * (index->token_count + 1));
+    index->block_offsets = (long *)malloc(sizeof(long) * (index->block_count + 1));
+    index->line_starts = (long *)malloc(sizeof(long) * index->line_count);
+    if (index->tokens == NULL || index->offsets == NULL ||
+        index->block_offsets == NULL || index->line_starts == NULL) {
+        fprintf(stderr, "Error: Failed to allocate memory for token index\n");
+        free_token_index(index);
+        return NULL;
+    }
+
+    // 填充 token 数组和稀疏块摘要，tokenize 按源代码顺序产生 token，天然有序
+    long position = 0;
+    list_for_each(pos, token_list_head) {
+        Token *token = list_entry(pos, Token, node);
+        index->tokens[position] = token;
+        index->offsets[position] = token->offset;
+        if (position % TOKEN_INDEX_BLOCK_SIZE == 0) {
+            index->block_offsets[position / TOKEN_INDEX_BLOCK_SIZE] = token->offset;
+        }
+        position++;
+    }
+
+    // 填充换行表，第一行从0开始，之后每一行从换行符的下一个字节开始
+    long line = 0;
+    index->line_starts[line++] = 0;
+    cursor = source_code;
+    while ((cursor = memchr(cursor, '\n', end - cursor)) != NULL) {
+        cursor++;
+        index->line_starts[line++] = cursor - source_code;
+    }
+
+    return index;
+}
+
+/**
+ * 释放位置索引（不释放 Token 本身）
+ * @param index 指向要释放的索引的指针
+ */
+void free_token_index(TokenIndex *index) {
+    if (index == NULL) {
+        return;
+    }
+    free(index->tokens);
+    free(index->offsets);
+    free(index->block_offsets);
+    free(index->line_starts);
+    free(index);
+}
+
+/**
+ * 按下标取 Token，可以配合 token_count 从任意位置开始遍历
+ * @param index 指向索引的指针
+ * @param position token 下标（从0开始）
+ * @return 返回对应的 Token，越界返回NULL
+ */
+Token *token_index_at(const TokenIndex *index, long position) {
+    if (position < 0 || position >= index->token_count) {
+        return NULL;
+    }
+    return index->tokens[position];
+}
+
+/**
+ * 查找覆盖某个字节偏移的 Token
+ * @param index 指向索引的指针
+ * @param offset 源代码中的字节偏移（从0开始）
+ * @return 返回覆盖该偏移的 Token，偏移落在空白或注释中返回NULL
+ */
+Token *token_index_find(const TokenIndex *index, long offset) {
+    // 最后一个起始偏移不超过 offset 的 token
+    long position = token_upper_bound(index, offset) - 1;
+    if (position < 0) {
+        return NULL;
+    }
+
+    Token *token = index->tokens[position];
+    if (offset < token->offset + token->length) {
+        return token;
+    }
+    return NULL;
+}
+
+/**
+ * 查找覆盖某行某列的 Token
+ * @param index 指向索引的指针
+ * @param line 行号（从1开始）
+ * @param column 列号（从1开始）
+ * @return 返回覆盖该位置的 Token，没有则返回NULL
+ */
+Token *token_index_find_at(const TokenIndex *index, long line, long column) {
+    long offset = token_index_line_column_to_offset(index, line, column);
+    if (offset < 0) {
+        return NULL;
+    }
+    return token_index_find(index, offset);
+}
+
+/**
+ * 查找与区间 [begin, end) 有重叠的所有 Token
+ * @param index 指向索引的指针
+ * @param begin 区间起始偏移（包含）
+ * @param end 区间结束偏移（不包含）
+ * @param first 输出参数，第一个命中 Token 的下标
+ * @return 返回命中的 Token 数量，命中的下标为 [*first, *first + 返回值)
+ */
+long token_index_range(const TokenIndex *index, long begin, long end, long *first) {
+    // 空区间不命中任何 token（即使 begin 落在某个 token 内部）
+    if (end <= begin) {
+        *first = token_upper_bound(index, begin);
+        return 0;
+    }
+
+    // token 之间互不重叠，结束偏移同样有序
+    // 起点：最后一个起始偏移不超过 begin 的 token 如果跨过了 begin 就从它开始，否则从下一个开始
+    long low = token_upper_bound(index, begin) - 1;
+    if (low < 0 || index->tokens[low]->offset + index->tokens[low]->length <= begin) {
+        low++;
+    }
+
+    // 终点：第一个起始偏移不小于 end 的 token（不包含）
+    long high = end > 0 ? token_upper_bound(index, end - 1) : 0;
+
+    *first = low;
+    return high > low ? high - low : 0;
+}
+
+/**
+ * 将行列号转换为字节偏移
+ * @param index 指向索引的指针
+ * @param line 行号（从1开始）
+ * @param column 列号（从1开始）
+ * @return 返回对应的字节偏移，位置不存在返回-1
+ */
+long token_index_line_column_to_offset(const TokenIndex *index, long line, long column) {
+    if (line < 1 || line > index->line_count || column < 1) {
+        return -1;
+    }
+
+    // 列号不能超出本行（换行符本身算作本行最后一列）
+    long line_end = line < index->line_count ? index->line_starts[line] : index->source_length + 1;
+    long offset = index->line_starts[line - 1] + column - 1;
+    if (offset >= line_end) {
+        return -1;
+    }
+    return offset;
+}
+
+/**
+ * 将字节偏移转换为行列号
+ * @param index 指向索引的指针
+ * @param offset 源代码中的字节偏移（从0开始）
+ * @param line 输出参数，行号（从1开始）
+ * @param column 输出参数，列号（从1开始）
+ * @return 成功返回1，偏移越界返回0
+ */
+int token_index_offset_to_line_column(const TokenIndex *index, long offset, long *line, long *column) {
+    if (offset < 0 || offset > index->source_length) {
+        return 0;
+    }
+
+    // 起始偏移不超过 offset 的行数就是行号
+    *line = upper_bound_in(index->line_starts, 0, index->line_count, offset);
+    *column = offset - index->line_starts[*line - 1] + 1;
+    return 1;
+}
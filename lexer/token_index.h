@@ -0,0 +1,94 @@
+#ifndef HC_COMPILER_TOKEN_INDEX_H
+#define HC_COMPILER_TOKEN_INDEX_H
+
+// Token 位置索引
+// Token 流是链表，想知道“第 N 个字节 / 第 L 行第 C 列是哪个 token”只能从头遍历
+// 这里在 Token 流旁边建立一份有序的起始偏移数组、稀疏块摘要和换行表，
+// 点查询和区间查询都是 O(log n)，查到的 Token 仍然挂在原链表上，可以从任意位置继续遍历
+
+#include "lexer.h"
+
+// 稀疏块摘要的块大小（每隔多少个 token 记录一次起始偏移）
+#define TOKEN_INDEX_BLOCK_SIZE 64
+
+// Token 位置索引结构体
+typedef struct token_index_struct {
+    Token **tokens;         // 按起始偏移排列的 token 指针数组
+    long *offsets;          // 每个 token 的起始偏移，和 tokens 一一对应
+    long token_count;       // token 数量
+    long *block_offsets;    // 稀疏块摘要，第 i 块第一个 token 的起始偏移
+    long block_count;       // 块数量
+    long *line_starts;      // 换行表，第 L 行（从1开始）的起始偏移保存在 line_starts[L - 1]
+    long line_count;        // 行数
+    long source_length;     // 源代码长度
+} TokenIndex;
+
+/**
+ * 为 Token 流建立位置索引
+ * @param token_list_head 指向 tokenize 返回的 Token 链表头结点的指针
+ * @param source_code 指向生成该 Token 流的源代码字符串的指针
+ * @return 返回指向新建索引的指针，失败返回NULL
+ */
+TokenIndex *create_token_index(LIST_NODE *token_list_head, const char *source_code);
+
+/**
+ * 释放位置索引（不释放 Token 本身）
+ * @param index 指向要释放的索引的指针
+ */
+void free_token_index(TokenIndex *index);
+
+/**
+ * 按下标取 Token，可以配合 token_count 从任意位置开始遍历
+ * @param index 指向索引的指针
+ * @param position token 下标（从0开始）
+ * @return 返回对应的 Token，越界返回NULL
+ */
+Token *token_index_at(const TokenIndex *index, long position);
+
+/**
+ * 查找覆盖某个字节偏移的 Token
+ * @param index 指向索引的指针
+ * @param offset 源代码中的字节偏移（从0开始）
+ * @return 返回覆盖该偏移的 Token，偏移落在空白或注释中返回NULL
+ */
+Token *token_index_find(const TokenIndex *index, long offset);
+
+/**
+ * 查找覆盖某行某列的 Token
+ * @param index 指向索引的指针
+ * @param line 行号（从1开始）
+ * @param column 列号（从1开始）
+ * @return 返回覆盖该位置的 Token，没有则返回NULL
+ */
+Token *token_index_find_at(const TokenIndex *index, long line, long column);
+
+/**
+ * 查找与区间 [begin, end) 有重叠的所有 Token
+ * @param index 指向索引的指针
+ * @param begin 区间起始偏移（包含）
+ * @param end 区间结束偏移（不包含）
+ * @param first 输出参数，第一个命中 Token 的下标
+ * @return 返回命中的 Token 数量，命中的下标为 [*first, *first + 返回值)
+ */
+long token_index_range(const TokenIndex *index, long begin, long end, long *first);
+
+/**
+ * 将行列号转换为字节偏移
+ * @param index 指向索引的指针
+ * @param line 行号（从1开始）
+ * @param column 列号（从1开始）
+ * @return 返回对应的字节偏移，位置不存在返回-1
+ */
+long token_index_line_column_to_offset(const TokenIndex *index, long line, long column);
+
+/**
+ * 将字节偏移转换为行列号
+ * @param index 指向索引的指针
+ * @param offset 源代码中的字节偏移（从0开始）
+ * @param line 输出参数，行号（从1开始）
+ * @param column 输出参数，列号（从1开始）
+ * @return 成功返回1，偏移越界返回0
+ */
+int token_index_offset_to_line_column(const TokenIndex *index, long offset, long *line, long *column);
+
+#endif //HC_COMPILER_TOKEN_INDEX_H
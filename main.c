@@ -2,21 +2,28 @@
 // Created by huangcheng on 2024/9/27.
 //
 
-// 现在只有一个词法分析器的组件
+// 现在只有一个词法分析器的组件，以及给构建系统用的依赖扫描器和源代码压缩输出
 // 语言标准是C89
 
 #include <stdio.h>
 #include "lexer/lexer.h"
+#include "depscan/depscan.h"
+#include "minify/minify.h"
 
 int main(int argc, char *argv[]) {
-    // 检查是否提供了文件路径
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <source_file_path>\n", argv[0]);
+    // 检查是否提供了文件路径，可选的第一个参数用来选择依赖扫描模式
+    // --deps 输出 Makefile 格式的依赖，--deps-json 输出 JSON 格式的依赖，--minify 输出压缩后的源代码
+    const char *mode = NULL;
+    if (argc == 3 && (strcmp(argv[1], "--deps") == 0 || strcmp(argv[1], "--deps-json") == 0 ||
+                      strcmp(argv[1], "--minify") == 0)) {
+        mode = argv[1];
+    } else if (argc != 2) {
+        fprintf(stderr, "Usage: %s [--deps | --deps-json | --minify] <source_file_path>\n", argv[0]);
         return 1;
     }
 
     // 打开指定的C语言源代码文件
-    const char *file_path = argv[1];
+    const char *file_path = argv[argc - 1];
     FILE *file = fopen(file_path, "r");
     if (!file) {
         fprintf(stderr, "Error: Could not open file %s\n", file_path);
@@ -36,17 +43,35 @@ int main(int argc, char *argv[]) {
     }
 
     // 读取文件内容
-    fread(source_code, 1, file_size, file);
-    source_code[file_size] = '\0';  // 确保以null终止
+    // 文本模式下换行符可能被转换，实际读到的字节数以 fread 返回值为准
+    size_t source_length = fread(source_code, 1, file_size, file);
+    source_code[source_length] = '\0';  // 确保以null终止
 
     fclose(file);  // 关闭文件
 
-    // 调用词法分析器解析源代码
-    // 并打印所有解析到的 Token
-    print_tokens(tokenize(source_code));
+    int status = 0;
+    if (mode != NULL && strcmp(mode, "--minify") == 0) {
+        // 压缩输出模式直接引用源代码中的片段写出，源代码在写完之前不能释放
+        if (minify_tokens(tokenize(source_code), source_code, fileno(stdout)) != 0) {
+            status = 1;
+        }
+    } else if (mode != NULL) {
+        // 依赖扫描模式只解析预处理指令，不做完整的词法分析
+        LIST_NODE *dependencies = scan_dependencies(source_code, (long)source_length);
+        if (strcmp(mode, "--deps") == 0) {
+            print_dependencies_make(dependencies, file_path);
+        } else {
+            print_dependencies_json(dependencies, file_path);
+        }
+        free_dependencies(dependencies);
+    } else {
+        // 调用词法分析器解析源代码
+        // 并打印所有解析到的 Token
+        print_tokens(tokenize(source_code));
+    }
 
     // 释放文件内容所占内存
     free(source_code);
 
-    return 0;
+    return status;
 }
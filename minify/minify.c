@@ -0,0 +1,333 @@
+#include "minify.h"
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+
+// Windows 没有 writev，用逐段 _write 代替
+struct iovec {
+    void *iov_base;
+    size_t iov_len;
+};
+
+long writev(int fd, const struct iovec *iov, int count);
+#else
+#include <sys/uio.h>
+#endif
+
+// 输出中的一段，直接引用源代码
+typedef struct minify_slice_struct {
+    long offset;        // 在源代码中的起始偏移
+    long length;        // 长度
+    TokenType type;     // 所属 token 的类型，unknown 为1时无意义
+    int unknown;        // 是否是词法分析器不认识的字符（例如 '$'、'@'）
+} MinifySlice;
+
+// 压缩输出的状态
+typedef struct minify_writer_struct {
+    struct iovec iov[MINIFY_IOV_BATCH];
+    int count;                  // iov 中已有的片段数量
+    int fd;                     // 输出的文件描述符
+    const char *source_code;    // 指向源代码字符串的指针
+    MinifySlice prev;           // 上一段
+    int has_prev;               // 是否已经输出过内容
+} MinifyWriter;
+
+// 辅助函数
+int emit_slice(MinifyWriter *writer, const MinifySlice *slice);
+int emit_unknown_chars(MinifyWriter *writer, long begin, long end);
+char separator_between(const MinifySlice *prev, const MinifySlice *next, const char *source_code);
+int is_word_char(char c);
+int ends_with_number(const char *source_code, long end);
+int is_punctuator_pair(char a, char b);
+int flush_iovecs(int fd, struct iovec *iov, int count);
+
+#ifdef _WIN32
+/**
+ * 按顺序写出多个片段
+ * @param fd 输出的文件描述符
+ * @param iov 片段数组
+ * @param count 片段数量
+ * @return 返回写出的字节数，一个字节都没写出就失败时返回-1
+ */
+long writev(int fd, const struct iovec *iov, int count) {
+    long total = 0;
+    for (int i = 0; i < count; i++) {
+        int written = _write(fd, iov[i].iov_base, (unsigned int)iov[i].iov_len);
+        if (written < 0) {
+            return total > 0 ? total : -1;
+        }
+        total += written;
+        if ((size_t)written < iov[i].iov_len) {
+            break;
+        }
+    }
+    return total;
+}
+#endif
+
+/**
+ * 将 Token 流压缩输出到文件描述符
+ * 词法分析器不认识的字符不产生 token，这些字符从 token 之间的间隙里找回来原样输出，
+ * 压缩前后的代码由词法分析器读出来的结果完全一样
+ * @param token_list_head 指向 tokenize 返回的 Token 链表头结点的指针
+ * @param source_code 指向生成该 Token 流的源代码字符串的指针
+ * @param fd 输出的文件描述符
+ * @return 成功返回0，写入失败返回-1
+ */
+int minify_tokens(LIST_NODE *token_list_head, const char *source_code, int fd) {
+    MinifyWriter writer;
+    writer.count = 0;
+    writer.fd = fd;
+    writer.source_code = source_code;
+    writer.has_prev = 0;
+    long prev_end = 0;  // 上一个 token 在源代码中的结束偏移
+
+    LIST_NODE *pos;
+    list_for_each(pos, token_list_head) {
+        Token *token = list_entry(pos, Token, node);
+
+        // 上一个 token 和这个 token 之间（包括文件末尾）除了空白和注释还可能有不认识的字符
+        if (token->offset > prev_end && emit_unknown_chars(&writer, prev_end, token->offset) != 0) {
+            return -1;
+        }
+        if (token->type == TOKEN_EOF || token->length == 0) {
+            continue;
+        }
+
+        // 预处理指令末尾可能带着 '\r' 或空格，不输出
+        MinifySlice slice = {token->offset, token->length, token->type, 0};
+        if (token->type == TOKEN_PREPROCESSOR) {
+            while (slice.length > 1 && strchr(" \t\r", source_code[slice.offset + slice.length - 1])) {
+                slice.length--;
+            }
+        }
+
+        if (emit_slice(&writer, &slice) != 0) {
+            return -1;
+        }
+        prev_end = token->offset + token->length;
+    }
+
+    // 以换行结尾，最后一个 token 是预处理指令时也能正确结束
+    if (writer.has_prev) {
+        if (writer.count + 1 > MINIFY_IOV_BATCH) {
+            if (flush_iovecs(fd, writer.iov, writer.count) != 0) {
+                return -1;
+            }
+            writer.count = 0;
+        }
+        writer.iov[writer.count].iov_base = "\n";
+        writer.iov[writer.count].iov_len = 1;
+        writer.count++;
+    }
+
+    return flush_iovecs(fd, writer.iov, writer.count);
+}
+
+/**
+ * 输出一段源代码，必要时在前面插入分隔符
+ * @param writer 指向压缩输出状态的指针
+ * @param slice 要输出的一段
+ * @return 成功返回0，写入失败返回-1
+ */
+int emit_slice(MinifyWriter *writer, const MinifySlice *slice) {
+    const char *source_code = writer->source_code;
+
+    // 源代码中紧挨着的片段原样输出，不插入分隔符：
+    // 词法分析器会把 0x1F、10UL、.5f、L"..." 这样的写法拆成多个 token，拆开之后就不是合法的C代码了
+    // 只有原来隔着空白或注释的地方才需要判断最小分隔符
+    long prev_end = writer->prev.offset + writer->prev.length;
+    long gap = writer->has_prev ? slice->offset - prev_end : 0;
+    char separator = gap > 0 ? separator_between(&writer->prev, slice, source_code) : '\0';
+
+    if (writer->count > 0 && (gap == 0 ||
+                              (separator != '\0' && gap == 1 && source_code[prev_end] == separator))) {
+        // 两段本来就紧挨着（或者恰好隔着需要的分隔符），直接延长上一段
+        writer->iov[writer->count - 1].iov_len += gap + slice->length;
+    } else {
+        if (writer->count + 2 > MINIFY_IOV_BATCH) {
+            if (flush_iovecs(writer->fd, writer->iov, writer->count) != 0) {
+                return -1;
+            }
+            writer->count = 0;
+        }
+        if (separator != '\0') {
+            writer->iov[writer->count].iov_base = separator == '\n' ? "\n" : " ";
+            writer->iov[writer->count].iov_len = 1;
+            writer->count++;
+        }
+        writer->iov[writer->count].iov_base = (void *)(source_code + slice->offset);
+        writer->iov[writer->count].iov_len = slice->length;
+        writer->count++;
+    }
+
+    writer->prev = *slice;
+    writer->has_prev = 1;
+    return 0;
+}
+
+/**
+ * 在两个 token 之间的间隙里跳过空白和注释（和词法分析器的规则一致），其余每个字符单独输出
+ * @param writer 指向压缩输出状态的指针
+ * @param begin 间隙起始偏移（包含）
+ * @param end 间隙结束偏移（不包含）
+ * @return 成功返回0，写入失败返回-1
+ */
+int emit_unknown_chars(MinifyWriter *writer, long begin, long end) {
+    const char *source_code = writer->source_code;
+    long cursor = begin;
+    while (cursor < end) {
+        char c = source_code[cursor];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            cursor++;
+        } else if (c == '/' && cursor + 1 < end && source_code[cursor + 1] == '/') {
+            while (cursor < end && source_code[cursor] != '\n') {
+                cursor++;
+            }
+        } else if (c == '/' && cursor + 1 < end && source_code[cursor + 1] == '*') {
+            // 没有闭合的注释一直延续到间隙末尾
+            cursor += 2;
+            while (cursor + 1 < end && !(source_code[cursor] == '*' && source_code[cursor + 1] == '/')) {
+                cursor++;
+            }
+            cursor += 2;
+        } else {
+            MinifySlice slice = {cursor, 1, TOKEN_EOF, 1};
+            if (emit_slice(writer, &slice) != 0) {
+                return -1;
+            }
+            cursor++;
+        }
+    }
+    return 0;
+}
+
+/**
+ * 判断相邻两段之间需要的最小分隔符
+ * @param prev 前一段
+ * @param next 后一段
+ * @param source_code 指向源代码字符串的指针
+ * @return 需要换行返回'\n'，需要空格返回' '，不需要分隔返回'\0'
+ */
+char separator_between(const MinifySlice *prev, const MinifySlice *next, const char *source_code) {
+    // 预处理指令必须独占一行
+    if ((!prev->unknown && prev->type == TOKEN_PREPROCESSOR) ||
+        (!next->unknown && next->type == TOKEN_PREPROCESSOR)) {
+        return '\n';
+    }
+
+    // 不认识的字符不知道会和相邻的内容怎样结合，原来隔开的地方保留一个空格
+    if (prev->unknown || next->unknown) {
+        return ' ';
+    }
+
+    char a = source_code[prev->offset + prev->length - 1];  // 前一段的最后一个字符
+    char b = source_code[next->offset];                     // 后一段的第一个字符
+
+    // 标识符、关键字、数字连在一起会变成一个 token；标识符紧跟引号会变成 L"..." 这样的宽字符常量
+    if (is_word_char(a) && (is_word_char(b) || b == '"' || b == '\'')) {
+        return ' ';
+    }
+
+    // 数字后面紧跟 '.'、'.' 后面紧跟数字、e/E 结尾的数字后面紧跟正负号，都会被读成同一个数
+    // 0x1E 这样的数会被拆成 "0" 和 "x1E" 两个 token，所以要从源代码里往回看整个数
+    int prev_is_number = ends_with_number(source_code, prev->offset + prev->length);
+    int next_is_number = next->type == TOKEN_INT || next->type == TOKEN_FLOAT;
+    if ((prev_is_number && (b == '.' || ((a == 'e' || a == 'E') && (b == '+' || b == '-')))) ||
+        (next_is_number && a == '.')) {
+        return ' ';
+    }
+
+    // 两个标点符号连在一起可能组成更长的标点符号或注释
+    if (is_punctuator_pair(a, b)) {
+        return ' ';
+    }
+
+    return '\0';
+}
+
+/**
+ * 判断字符是否可以出现在标识符、关键字或数字中
+ * @param c 要检查的字符
+ * @return 可以返回1，否则返回0
+ */
+int is_word_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+ * 判断源代码中某个位置之前紧挨着的是不是一个数（C 预处理数，以数字或 '.' 加数字开头）
+ * @param source_code 指向源代码字符串的指针
+ * @param end 结束偏移（不包含）
+ * @return 是数返回1，否则返回0
+ */
+int ends_with_number(const char *source_code, long end) {
+    long start = end;
+    while (start > 0 && (is_word_char(source_code[start - 1]) || source_code[start - 1] == '.')) {
+        start--;
+    }
+    // 跳过前面的 '.'，例如 "a.b" 中的 ".b" 不是数，".5" 是数
+    while (start < end && source_code[start] == '.') {
+        start++;
+    }
+    return start < end && source_code[start] >= '0' && source_code[start] <= '9';
+}
+
+/**
+ * 判断两个字符连在一起是否是某个多字符标点符号的开头（或注释的开头）
+ * C89 的三字符标点 "<<="、">>="、"..." 的前两个字符也在其中，所以只看相邻的两个字符就够了
+ * @param a 前一个字符
+ * @param b 后一个字符
+ * @return 是返回1，否则返回0
+ */
+int is_punctuator_pair(char a, char b) {
+    switch (a) {
+        case '+': return b == '+' || b == '=';
+        case '-': return b == '-' || b == '=' || b == '>';
+        case '&': return b == '&' || b == '=';
+        case '|': return b == '|' || b == '=';
+        case '<': return b == '<' || b == '=';
+        case '>': return b == '>' || b == '=';
+        case '/': return b == '/' || b == '*' || b == '=';
+        case '.': return b == '.';
+        case '*':
+        case '%':
+        case '^':
+        case '!':
+        case '=': return b == '=';
+        default: return 0;
+    }
+}
+
+/**
+ * 用 writev 写出一批片段，处理被信号打断和只写出一部分的情况
+ * @param fd 输出的文件描述符
+ * @param iov 片段数组（部分写出时会被修改）
+ * @param count 片段数量
+ * @return 成功返回0，写入失败返回-1
+ */
+int flush_iovecs(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        long written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Error: Failed to write output: %s\n", strerror(errno));
+            return -1;
+        }
+
+        // 跳过已经完整写出的片段，剩下的从断点继续
+        while (count > 0 && (size_t)written >= iov->iov_len) {
+            written -= (long)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return 0;
+}
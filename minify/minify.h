@@ -0,0 +1,23 @@
+#ifndef HC_COMPILER_MINIFY_H
+#define HC_COMPILER_MINIFY_H
+
+// 源代码压缩输出
+// 根据 Token 流重建去掉注释和多余空白的源代码，每个 token 直接引用原始输入中的一段（offset 和 length），
+// 相邻 token 之间只在必要时插入一个空格或换行，最后用 writev 批量写出，全程不格式化、不拷贝 token 内容
+// 词法分析器不认识的字符（例如 '$'）也原样保留，压缩前后的代码读出来的 Token 流相同
+
+#include "../lexer/lexer.h"
+
+// 每次 writev 最多提交的片段数量
+#define MINIFY_IOV_BATCH 1024
+
+/**
+ * 将 Token 流压缩输出到文件描述符
+ * @param token_list_head 指向 tokenize 返回的 Token 链表头结点的指针
+ * @param source_code 指向生成该 Token 流的源代码字符串的指针
+ * @param fd 输出的文件描述符
+ * @return 成功返回0，写入失败返回-1
+ */
+int minify_tokens(LIST_NODE *token_list_head, const char *source_code, int fd);
+
+#endif //HC_COMPILER_MINIFY_H
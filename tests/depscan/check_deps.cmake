@@ -0,0 +1,15 @@
+# 依赖扫描输出必须和期望的输出完全一致
+# 参数：HC_COMPILER、MODE、SOURCE、EXPECTED、WORKING_DIRECTORY
+
+execute_process(COMMAND ${HC_COMPILER} ${MODE} ${SOURCE}
+                WORKING_DIRECTORY ${WORKING_DIRECTORY}
+                OUTPUT_VARIABLE output
+                RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "HC_Compiler ${MODE} failed on ${SOURCE}")
+endif ()
+
+file(READ ${EXPECTED} expected)
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "Unexpected output for ${MODE} ${SOURCE}:\n${output}\nExpected:\n${expected}")
+endif ()
@@ -0,0 +1,10 @@
+/* 真正的头文件保护：第一条内容是 #ifndef，#endif 之后只有注释 */
+#ifndef GUARD_H
+// 注释可以夹在中间
+#define GUARD_H
+#include "plain.h"
+/* hdr */ #include "after_comment.h"
+#ifdef FEATURE
+#include "feature.h"
+#endif
+#endif /* GUARD_H */
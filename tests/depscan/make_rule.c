@@ -0,0 +1,9 @@
+#include <stdio.h>
+#include "$(foo).h"
+#include "a#b.h"
+#include "with space.h"
+#ifdef A
+#include "twice.h"
+#else
+#include "twice.h"
+#endif
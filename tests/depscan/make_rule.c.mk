@@ -0,0 +1,5 @@
+make_rule.o: make_rule.c \
+  $$(foo).h \
+  a\#b.h \
+  with\ space.h \
+  twice.h
@@ -0,0 +1,5 @@
+#ifndef HAVE_FOO
+#define HAVE_FOO 1
+#include "fallback.h"
+#endif
+int after_endif;
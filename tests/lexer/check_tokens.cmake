@@ -0,0 +1,14 @@
+# Token 流的打印结果必须和期望的输出完全一致
+# 参数：HC_COMPILER、SOURCE、EXPECTED
+
+execute_process(COMMAND ${HC_COMPILER} ${SOURCE}
+                OUTPUT_VARIABLE output
+                RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "HC_Compiler failed on ${SOURCE}")
+endif ()
+
+file(READ ${EXPECTED} expected)
+if (NOT output STREQUAL expected)
+    message(FATAL_ERROR "Unexpected tokens for ${SOURCE}:\n${output}\nExpected:\n${expected}")
+endif ()
@@ -0,0 +1,11 @@
+#define LIMIT 10
+a<<=b>>=c;
+f(a,...);
+p->q-=1;
+x..y;
+a/=b/*comment*/;
+c=a<<b>>d<=e>=f%g^~h;
+i=j&&k||!l!=m==n?o:p;
+q+=r;q*=r;q%=r;q&=r;q|=r;q^=r;
+s++ + ++t- --u--;
+s="str";t='c';
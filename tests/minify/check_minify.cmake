@@ -0,0 +1,35 @@
+# 压缩输出后用真正的编译器检查语法，并检查压缩前后词法分析器读出来的 Token 流相同
+# 参数：HC_COMPILER、C_COMPILER、SOURCE、OUTPUT
+
+execute_process(COMMAND ${HC_COMPILER} --minify ${SOURCE}
+                OUTPUT_FILE ${OUTPUT}
+                RESULT_VARIABLE minify_result)
+if (NOT minify_result EQUAL 0)
+    message(FATAL_ERROR "HC_Compiler --minify failed on ${SOURCE}")
+endif ()
+
+execute_process(COMMAND ${C_COMPILER} -fsyntax-only -Wno-multichar -x c ${OUTPUT}
+                RESULT_VARIABLE compile_result)
+if (NOT compile_result EQUAL 0)
+    message(FATAL_ERROR "Minified output ${OUTPUT} does not compile")
+endif ()
+
+# 压缩前后各自输出 Token 流，去掉行列号后必须完全相同（包括不认识的字符的警告）
+foreach (file SOURCE OUTPUT)
+    execute_process(COMMAND ${HC_COMPILER} ${${file}}
+                    OUTPUT_VARIABLE tokens
+                    ERROR_VARIABLE warnings
+                    RESULT_VARIABLE dump_result)
+    if (NOT dump_result EQUAL 0)
+        message(FATAL_ERROR "HC_Compiler failed to dump tokens of ${${file}}")
+    endif ()
+    string(REGEX REPLACE ", Line=-?[0-9]+, Column=-?[0-9]+" "" ${file}_tokens "${tokens}")
+    string(REGEX REPLACE " at line -?[0-9]+, column -?[0-9]+" "" ${file}_warnings "${warnings}")
+endforeach ()
+
+if (NOT SOURCE_tokens STREQUAL OUTPUT_tokens)
+    message(FATAL_ERROR "Token stream of ${OUTPUT} differs from ${SOURCE}:\n${SOURCE_tokens}\n--- minified ---\n${OUTPUT_tokens}")
+endif ()
+if (NOT SOURCE_warnings STREQUAL OUTPUT_warnings)
+    message(FATAL_ERROR "Unrecognized characters of ${OUTPUT} differ from ${SOURCE}:\n${SOURCE_warnings}\n--- minified ---\n${OUTPUT_warnings}")
+endif ()
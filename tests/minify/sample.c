@@ -0,0 +1,24 @@
+/* 压缩输出测试用例：压缩后的代码必须能被真正的编译器接受 */
+#include <stddef.h>
+#define ADD(a, b) \
+    ((a) + (b))
+
+unsigned long hex_value = 0x1F + 10UL;  // 十六进制常量和整数后缀
+unsigned long exponent_like = 0x1E + 1;
+long long_value = 077L - 1l;
+float small = .5f;
+double scaled = 1.5e-3 + 2. + 1e+5;
+wchar_t *wide = L"wide";
+int multi_char = 'ab';
+char *text = "a  /* not a comment */";
+int $dollar = 1;   // 词法分析器不认识 '$'，gcc 和 clang 允许它出现在标识符中
+
+int sum(int count, ...) {
+    int x = count + +1, y = x - -2, *p = &x;
+    x <<= 2;
+    y >>= 1;
+    x = x - /* 注释 */ -y + $dollar;
+    y = y -/**/- x;
+    x = x < -y ? x / *p : y & &x != NULL;
+    return ADD(x, y) + small + p[0];
+}
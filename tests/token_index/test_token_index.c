@@ -0,0 +1,180 @@
+// Token 位置索引测试：点查询、区间查询、行列号换算，以及超过一个块（64个 token）时的稀疏块摘要
+
+#include "../../lexer/token_index.h"
+
+// 失败的检查数量
+int failures = 0;
+
+// 检查条件，失败时打印所在行，继续执行后面的检查
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+/**
+ * 线性遍历索引，查找覆盖某个偏移的 token 下标，作为二分查找的对照
+ * @param index 指向索引的指针
+ * @param offset 字节偏移
+ * @return 返回 token 下标，没有则返回-1
+ */
+long linear_find(const TokenIndex *index, long offset) {
+    for (long i = 0; i < index->token_count; i++) {
+        Token *token = index->tokens[i];
+        if (offset >= token->offset && offset < token->offset + token->length) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * 线性统计与区间 [begin, end) 重叠的 token，作为区间查询的对照
+ * @param index 指向索引的指针
+ * @param begin 区间起始偏移（包含）
+ * @param end 区间结束偏移（不包含）
+ * @param first 输出参数，第一个命中 token 的下标
+ * @return 返回命中的 token 数量
+ */
+long linear_range(const TokenIndex *index, long begin, long end, long *first) {
+    long count = 0;
+    *first = -1;
+    if (end <= begin) {
+        return 0;   // 空区间不命中任何 token
+    }
+    for (long i = 0; i < index->token_count; i++) {
+        Token *token = index->tokens[i];
+        if (token->offset < end && token->offset + token->length > begin) {
+            if (count == 0) {
+                *first = i;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * 对所有偏移和若干区间，把索引的结果和线性遍历的结果对照
+ * @param index 指向索引的指针
+ */
+void check_against_linear(const TokenIndex *index) {
+    for (long offset = 0; offset <= index->source_length; offset++) {
+        long expected = linear_find(index, offset);
+        Token *found = token_index_find(index, offset);
+        CHECK(expected < 0 ? found == NULL : found == index->tokens[expected]);
+
+        // 行列号往返
+        long line, column;
+        CHECK(token_index_offset_to_line_column(index, offset, &line, &column));
+        CHECK(token_index_line_column_to_offset(index, line, column) == offset);
+        CHECK(token_index_find_at(index, line, column) == found);
+    }
+
+    for (long begin = 0; begin <= index->source_length; begin += 7) {
+        for (long end = begin; end <= index->source_length + 1; end += 13) {
+            long expected_first, first;
+            long expected = linear_range(index, begin, end, &expected_first);
+            long count = token_index_range(index, begin, end, &first);
+            CHECK(count == expected);
+            if (expected > 0) {
+                CHECK(first == expected_first);
+            }
+        }
+    }
+}
+
+/**
+ * 小输入：token 起点、终点、空白、注释和 EOF
+ */
+void test_small_source() {
+    const char *source = "int main() {\n  /* c */ return a+b;\n}\n";
+    TokenIndex *index = create_token_index(tokenize(source), source);
+    CHECK(index != NULL);
+
+    // 起点和终点："int" 占 [0, 3)
+    Token *token = token_index_find(index, 0);
+    CHECK(token != NULL && token->type == TOKEN_KEYWORD && token->offset == 0 && token->length == 3);
+    CHECK(token_index_find(index, 2) == token);
+    CHECK(token_index_find(index, 3) == NULL);   // "int" 之后的空格
+
+    // 注释内部和注释前后的空白
+    const char *comment = strstr(source, "/* c */");
+    for (long offset = comment - source - 1; offset <= comment - source + 7; offset++) {
+        CHECK(token_index_find(index, offset) == NULL);
+    }
+
+    // "return" 紧跟在注释之后的空格后面
+    long return_offset = strstr(source, "return") - source;
+    token = token_index_find(index, return_offset);
+    CHECK(token != NULL && token->type == TOKEN_KEYWORD && token->offset == return_offset);
+    CHECK(token_index_find_at(index, 2, 11) == token);
+
+    // EOF token 长度为0，不覆盖任何偏移，但可以按下标取到
+    Token *eof = token_index_at(index, index->token_count - 1);
+    CHECK(eof != NULL && eof->type == TOKEN_EOF && eof->offset == index->source_length);
+    CHECK(token_index_find(index, index->source_length) == NULL);
+    CHECK(token_index_at(index, index->token_count) == NULL);
+    CHECK(token_index_at(index, -1) == NULL);
+
+    // 空区间、只落在空白中的区间、部分重叠的区间
+    long first;
+    CHECK(token_index_range(index, 5, 5, &first) == 0);   // 空区间，即使落在 "main" 内部
+    CHECK(token_index_range(index, 3, 4, &first) == 0);
+    CHECK(token_index_range(index, 1, 6, &first) == 2 && first == 0);   // "int" 的后半和 "main" 的前半
+    CHECK(token_index_range(index, 0, index->source_length, &first) == index->token_count - 1 && first == 0);
+    CHECK(token_index_range(index, 4, 3, &first) == 0);
+
+    // 越界的行列号
+    CHECK(token_index_line_column_to_offset(index, 0, 1) == -1);
+    CHECK(token_index_line_column_to_offset(index, 1, 0) == -1);
+    CHECK(token_index_line_column_to_offset(index, 1, 14) == -1);   // 第一行只有13列（包括换行符）
+    CHECK(token_index_line_column_to_offset(index, index->line_count + 1, 1) == -1);
+
+    check_against_linear(index);
+    free_token_index(index);
+}
+
+/**
+ * 大输入：token 数量超过多个块，二分查找要经过稀疏块摘要
+ */
+void test_multiple_blocks() {
+    char source[16384];
+    long length = 0;
+    for (int i = 0; i < 200; i++) {
+        length += sprintf(source + length, "x%d = %d; /* %d */\n", i, i, i);
+    }
+
+    TokenIndex *index = create_token_index(tokenize(source), source);
+    CHECK(index != NULL);
+    CHECK(index->token_count > 3 * TOKEN_INDEX_BLOCK_SIZE);
+    CHECK(index->block_count == (index->token_count + TOKEN_INDEX_BLOCK_SIZE - 1) / TOKEN_INDEX_BLOCK_SIZE);
+
+    // 每个 token 都能从它的起点和最后一个字节查回来，区间查询恰好命中它自己
+    for (long i = 0; i < index->token_count - 1; i++) {
+        Token *token = index->tokens[i];
+        CHECK(token_index_find(index, token->offset) == token);
+        CHECK(token_index_find(index, token->offset + token->length - 1) == token);
+
+        long first;
+        CHECK(token_index_range(index, token->offset, token->offset + token->length, &first) == 1);
+        CHECK(first == i);
+    }
+
+    check_against_linear(index);
+    free_token_index(index);
+}
+
+int main() {
+    test_small_source();
+    test_multiple_blocks();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All token index checks passed\n");
+    return 0;
+}